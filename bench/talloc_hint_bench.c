@@ -0,0 +1,102 @@
+/*  talloc_hint_bench.c
+    Fragmentation under a mixed workload: `talloc` vs `talloc_hint`.
+    Every request keeps one long lived table and one small hot object. Its scratch buffers and a short lived hot object
+    are freed when the next request ends.
+    Build: cc -O2 -I.. talloc_hint_bench.c -o talloc_hint_bench
+*/
+#define TALLOC_IMPLEMENTATION
+#define TALLOC_PACKED_SEARCH
+#define TALLOC_MAX_HEAP_CHUNKS (1024 * 16)
+#define TALLOC_MAX_HEAP_SIZE (1024 * 1024 * 16)
+#include "../tiny_alloc_single_header.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define BENCH_REQUESTS 2000
+#define BENCH_SCRATCH_PER_REQUEST 4
+#define BENCH_HOT_SIZE 16
+#define BENCH_PAGE_SIZE 4096
+
+static uint32_t benchSeed;
+static uint32_t bench_random(uint32_t bound) {
+    benchSeed = benchSeed * 1664525u + 1013904223u;
+    return (benchSeed >> 8) % bound;
+}
+
+static int bench_compare_pages(const void* left, const void* right) {
+    const uintptr_t l = *(const uintptr_t*)left;
+    const uintptr_t r = *(const uintptr_t*)right;
+    return (l > r) - (l < r);
+}
+
+static void bench_workload(TALLOC_BOOL useHints) {
+    static void* scratch[2][BENCH_SCRATCH_PER_REQUEST];
+    static void* shortHot[2];
+    static uintptr_t hotPages[BENCH_REQUESTS];
+    int hotCount = 0;
+    char* longEnd = 0; // end of the highest long lived block
+    int shortHotInLong = 0; // short lived hot objects placed below it
+    talloc_initialize_chunks();
+    benchSeed = 42;
+    for (int request = 0; request < BENCH_REQUESTS; ++request) {
+        void** current = scratch[request & 1];
+        void** previous = scratch[(request + 1) & 1];
+        for (int i = 0; i < BENCH_SCRATCH_PER_REQUEST; ++i) {
+            const TALLOC_SIZE_TYPE size = 256 + bench_random(4096);
+            current[i] = useHints ? talloc_hint(size, TALLOC_HINT_SHORT_LIVED) : talloc(size);
+        }
+        const TALLOC_SIZE_TYPE tableSize = 64 + bench_random(1024);
+        void* table = useHints ? talloc_hint(tableSize, TALLOC_HINT_LONG_LIVED) : talloc(tableSize);
+        void* hot = useHints ? talloc_hint(BENCH_HOT_SIZE, TALLOC_HINT_LONG_LIVED | TALLOC_HINT_HOT) : talloc(BENCH_HOT_SIZE);
+        shortHot[request & 1] = useHints ? talloc_hint(BENCH_HOT_SIZE, TALLOC_HINT_SHORT_LIVED | TALLOC_HINT_HOT) : talloc(BENCH_HOT_SIZE);
+        if ((table == 0) || (hot == 0) || (shortHot[request & 1] == 0)) {
+            printf("  heap exhausted at request %d\n", request);
+            break;
+        }
+        hotPages[hotCount++] = (uintptr_t)hot / BENCH_PAGE_SIZE;
+        if ((char*)table + tableSize > longEnd)
+            longEnd = (char*)table + tableSize;
+        if ((char*)hot + BENCH_HOT_SIZE > longEnd)
+            longEnd = (char*)hot + BENCH_HOT_SIZE;
+        if ((char*)shortHot[request & 1] < longEnd)
+            ++shortHotInLong;
+        if (request > 0) {
+            for (int i = 0; i < BENCH_SCRATCH_PER_REQUEST; ++i) {
+                tfree(previous[i]);
+            }
+            tfree(shortHot[(request + 1) & 1]);
+        }
+    }
+
+    TALLOC_SIZE_TYPE freeChunks = 0;
+    TALLOC_SIZE_TYPE freeBytes = 0;
+    TALLOC_SIZE_TYPE largestFree = 0;
+    for (heap_chunk* current = tallocHead; current != 0; current = current->next) {
+        if (!current->isFree)
+            continue;
+        ++freeChunks;
+        freeBytes += current->count;
+        if (current->count > largestFree)
+            largestFree = current->count;
+    }
+    qsort(hotPages, hotCount, sizeof(hotPages[0]), bench_compare_pages);
+    int hotPageCount = 0;
+    for (int i = 0; i < hotCount; ++i) {
+        if ((i == 0) || (hotPages[i] != hotPages[i - 1]))
+            ++hotPageCount;
+    }
+    printf("  %-12s chunks %6zu, free chunks %6zu, free %9zu B, largest free %9zu B, fragmentation %5.2f%%, hot data on %4d pages, short lived hot objects among long lived %4d\n",
+        useHints ? "talloc_hint" : "talloc", tallocChunksCount, freeChunks, freeBytes, largestFree,
+        freeBytes ? 100.0 * (1.0 - (double)largestFree / (double)freeBytes) : 0.0, hotPageCount, shortHotInLong);
+}
+
+int main() {
+    talloc(1); // initializes the heap
+    printf("%d requests, %d scratch buffers and a short lived hot object each, %d B of long lived hot data (fragmentation = 1 - largest free / free):\n",
+        BENCH_REQUESTS, BENCH_SCRATCH_PER_REQUEST, BENCH_REQUESTS * BENCH_HOT_SIZE);
+    bench_workload(TALLOC_FALSE);
+    bench_workload(TALLOC_TRUE);
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*  talloc_pmr_bench.cpp
+    std::vector, std::unordered_map and std::list workloads: default allocator vs talloc adapters.
+    Build: c++ -std=c++17 -O2 -I.. talloc_pmr_bench.cpp -o talloc_pmr_bench
+*/
+#define TALLOC_IMPLEMENTATION
+#define TALLOC_MAX_HEAP_CHUNKS (1024 * 64)
+#define TALLOC_MAX_HEAP_SIZE (1024 * 1024 * 64)
+#include "../tiny_alloc_pmr.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+static constexpr int benchElements = 1024 * 16;
+static constexpr int benchRounds = 20;
+static volatile std::size_t benchSink;
+
+template <class Fn>
+static void bench_run(const char* workload, const char* allocatorName, Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < benchRounds; ++round) {
+        fn();
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("  %-14s %-22s %9.3f ms/round\n", workload, allocatorName, elapsed.count() / benchRounds);
+}
+
+template <class Vector>
+static void bench_vector(Vector&& vector) {
+    for (int i = 0; i < benchElements; ++i) {
+        vector.push_back(i);
+    }
+    benchSink = vector.size();
+}
+template <class Map>
+static void bench_map(Map&& map) {
+    for (int i = 0; i < benchElements; ++i) {
+        map.emplace(i * 7, i);
+    }
+    for (int i = 0; i < benchElements; i += 2) {
+        map.erase(i * 7);
+    }
+    benchSink = map.size();
+}
+template <class List>
+static void bench_list(List&& list) {
+    for (int i = 0; i < benchElements; ++i) {
+        list.push_back(i);
+    }
+    for (auto it = list.begin(); it != list.end();) {
+        it = list.erase(it); // erase every other node
+        if (it != list.end())
+            ++it;
+    }
+    benchSink = list.size();
+}
+
+int main() {
+    std::printf("%d elements, %d rounds:\n", benchElements, benchRounds);
+
+    bench_run("vector", "std::allocator", [] { bench_vector(std::vector<int>()); });
+    bench_run("vector", "tiny_alloc::allocator", [] { bench_vector(std::vector<int, tiny_alloc::allocator<int>>()); });
+    bench_run("vector", "pmr talloc", [] { bench_vector(std::pmr::vector<int>(tiny_alloc::get_memory_resource())); });
+    bench_run("vector", "tiny_alloc::region", [] { tiny_alloc::region region; bench_vector(std::pmr::vector<int>(&region)); });
+
+    using talloc_map = std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, tiny_alloc::allocator<std::pair<const int, int>>>;
+    bench_run("unordered_map", "std::allocator", [] { bench_map(std::unordered_map<int, int>()); });
+    bench_run("unordered_map", "tiny_alloc::allocator", [] { bench_map(talloc_map()); });
+    bench_run("unordered_map", "pmr talloc", [] { bench_map(std::pmr::unordered_map<int, int>(tiny_alloc::get_memory_resource())); });
+    bench_run("unordered_map", "tiny_alloc::region", [] { tiny_alloc::region region; bench_map(std::pmr::unordered_map<int, int>(&region)); });
+
+    bench_run("list", "std::allocator", [] { bench_list(std::list<int>()); });
+    bench_run("list", "tiny_alloc::allocator", [] { bench_list(std::list<int, tiny_alloc::allocator<int>>()); });
+    bench_run("list", "pmr talloc", [] { bench_list(std::pmr::list<int>(tiny_alloc::get_memory_resource())); });
+    bench_run("list", "tiny_alloc::region", [] { tiny_alloc::region region; bench_list(std::pmr::list<int>(&region)); });
+    return 0;
+}
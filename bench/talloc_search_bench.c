@@ -0,0 +1,90 @@
+/*  talloc_search_bench.c
+    Free chunk search throughput: serial walk over the chunk list vs packed size array (scalar, sse4.1, avx2).
+    Build: cc -O2 -I.. talloc_search_bench.c -o talloc_search_bench
+*/
+#define TALLOC_IMPLEMENTATION
+#define TALLOC_PACKED_SEARCH
+#define TALLOC_MAX_HEAP_CHUNKS (1024 * 72)
+#define TALLOC_MAX_HEAP_SIZE (1024 * 1024 * 8)
+#include "../tiny_alloc_single_header.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_BLOCK 16
+#define BENCH_REQUEST 32
+#define BENCH_MAX_BLOCKS (1024 * 64 + 1)
+
+static void* benchBlocks[BENCH_MAX_BLOCKS];
+
+static double bench_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Builds a heap of ~`chunks` chunks where only the last (highest address) hole fits BENCH_REQUEST,
+// so first fit has to look through the whole heap, as best fit always does.
+static void bench_fill(size_t chunks) {
+    talloc_initialize_chunks();
+    const size_t blocks = chunks / 2 * 2 + 1;
+    for (size_t i = 0; i < blocks; ++i) {
+        benchBlocks[i] = talloc(BENCH_BLOCK);
+    }
+    talloc(tallocHead->count); // plug the head remainder, blocks are carved from the tail
+    for (size_t i = 0; i < 3; ++i) {
+        tfree(benchBlocks[i]); // 48 byte hole at the end of the heap
+    }
+    for (size_t i = 5; i < blocks; i += 2) {
+        tfree(benchBlocks[i]); // 16 byte holes everywhere else
+    }
+}
+
+static volatile void* benchSink;
+
+static void bench_linked(size_t iterations, TALLOC_BOOL bestFit, const char* fitName) {
+    const double start = bench_now();
+    for (size_t i = 0; i < iterations; ++i) {
+        benchSink = talloc__linked_find(BENCH_REQUEST, bestFit);
+    }
+    const double elapsed = bench_now() - start;
+    printf("  %-6s %-8s %10.0f searches/s %8.2f GB/s chunks scanned\n", fitName, "linked",
+        iterations / elapsed, (double)iterations * tallocChunksCount * sizeof(heap_chunk) / elapsed * 1e-9);
+}
+
+static void bench_packed(size_t iterations, const talloc_packed_engine* engine, TALLOC_BOOL bestFit, const char* fitName) {
+    tallocPackedEngine = engine;
+    const double start = bench_now();
+    for (size_t i = 0; i < iterations; ++i) {
+        benchSink = talloc__packed_find(BENCH_REQUEST, bestFit);
+    }
+    const double elapsed = bench_now() - start;
+    printf("  %-6s %-8s %10.0f searches/s %8.2f GB/s sizes scanned\n", fitName, engine->name,
+        iterations / elapsed, (double)iterations * tallocPackedCount * sizeof(uint32_t) / elapsed * 1e-9);
+}
+
+int main() {
+    talloc(1); // initializes the heap and picks the engine
+    const talloc_packed_engine* detected = tallocPackedEngine;
+    printf("detected engine: %s\n", detected->name);
+
+    const size_t sizes[] = { 1024, 1024 * 4, 1024 * 64 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        bench_fill(sizes[s]);
+        const size_t iterations = (size_t)1024 * 1024 * 64 / sizes[s];
+        printf("%zu chunks (%zu iterations):\n", tallocChunksCount, iterations);
+        for (int fit = 0; fit < 2; ++fit) {
+            const char* fitName = fit ? "best" : "first";
+            bench_linked(iterations, fit, fitName);
+            bench_packed(iterations, &tallocPackedScalar, fit, fitName);
+#if TALLOC_PACKED_X86
+            if (detected != &tallocPackedScalar)
+                bench_packed(iterations, &tallocPackedSse41, fit, fitName);
+            if (detected == &tallocPackedAvx2)
+                bench_packed(iterations, &tallocPackedAvx2, fit, fitName);
+#endif
+        }
+        tallocPackedEngine = detected;
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*  tiny_alloc_pmr.hpp
+    MIT License
+
+    Copyright (c) 2024 Shigapov Aidar
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+// C++17 adapters over tiny_alloc_single_header.h. Define TALLOC_IMPLEMENTATION (and the other TALLOC_* options)
+// in exactly one translation unit before including this header, same as for the C header.
+// Containers free every block they allocate, so the implementation is built with TALLOC_PACKED_SEARCH:
+// tfree then finds the chunk by binary search over the address ordered index instead of walking the chunk list.
+// If the implementation is compiled in another translation unit, define TALLOC_PACKED_SEARCH there too.
+#ifndef TINY_ALLOC_PMR_HPP_
+#define TINY_ALLOC_PMR_HPP_
+
+#ifdef TALLOC_IMPLEMENTATION
+#   if defined(TINY_ALLOC_SINGLE_HEADER_H_) && !defined(TALLOC_PACKED_SEARCH)
+#       error "the talloc implementation is already included without TALLOC_PACKED_SEARCH, include tiny_alloc_pmr.hpp first or define it"
+#   endif
+#   ifndef TALLOC_PACKED_SEARCH
+#       define TALLOC_PACKED_SEARCH
+#   endif
+#endif
+#include "tiny_alloc_single_header.h"
+
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <new>
+
+namespace tiny_alloc {
+
+/// @brief `std::pmr::memory_resource` over the talloc heap. All instances share the one heap, so they all compare equal.
+///        Size and alignment of `deallocate` are not needed: chunk descriptors are not stored next to the data,
+///        so the pointer is looked up in the address ordered index either way (binary search).
+class memory_resource final : public std::pmr::memory_resource {
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* pointer = talloc_aligned(bytes == 0 ? 1 : bytes, alignment);
+        if (pointer == nullptr)
+            throw std::bad_alloc();
+        return pointer;
+    }
+    void do_deallocate(void* pointer, std::size_t, std::size_t) override {
+        tfree(pointer);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return dynamic_cast<const memory_resource*>(&other) != nullptr;
+    }
+};
+
+/// @brief Process wide instance of `tiny_alloc::memory_resource`.
+inline memory_resource* get_memory_resource() noexcept {
+    static memory_resource resource;
+    return &resource;
+}
+
+/// @brief Stateless allocator for STL containers. Throws `std::bad_alloc` when the talloc heap is exhausted.
+template <class T>
+class allocator {
+public:
+    using value_type = T;
+
+    allocator() noexcept = default;
+    template <class U>
+    allocator(const allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t count) {
+        if (count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        void* pointer = talloc_aligned(count == 0 ? 1 : count * sizeof(T), alignof(T));
+        if (pointer == nullptr)
+            throw std::bad_alloc();
+        return static_cast<T*>(pointer);
+    }
+    void deallocate(T* pointer, std::size_t) noexcept {
+        tfree(pointer);
+    }
+};
+template <class T, class U>
+bool operator==(const allocator<T>&, const allocator<U>&) noexcept { return true; }
+template <class T, class U>
+bool operator!=(const allocator<T>&, const allocator<U>&) noexcept { return false; }
+
+/// @brief RAII monotonic region: bump allocates from blocks taken from the talloc heap, `deallocate` does nothing,
+///        everything goes back to the heap with `release` or when the region is destroyed.
+class region final : public std::pmr::monotonic_buffer_resource {
+public:
+    explicit region(std::size_t initialSize = 4096)
+        : std::pmr::monotonic_buffer_resource(initialSize, get_memory_resource()) {}
+    region(const region&) = delete;
+    region& operator=(const region&) = delete;
+};
+
+} // namespace tiny_alloc
+
+#endif // TINY_ALLOC_PMR_HPP_
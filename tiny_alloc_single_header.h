@@ -22,6 +22,7 @@
     SOFTWARE.
 */
 #ifndef TINY_ALLOC_SINGLE_HEADER_H_
+#define TINY_ALLOC_SINGLE_HEADER_H_
 
 #ifndef TALLOC_ASSERT
 #   include <assert.h>
@@ -47,6 +48,10 @@
 #   define TALLOC_DEF extern
 #endif
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /** 
  * @brief  A function that allocates an amount of memory equal to `count`. Returns `0` if the function fails for some reason.
  *          If the function returns `0`, it is usually due to the virtual heap size being too small. You can change its size by modifying `TALLOC_MAX_HEAP_SIZE`.
@@ -72,11 +77,70 @@ TALLOC_DEF void* trealloc(void* pointer, TALLOC_SIZE_TYPE count, const int copyO
 /// @brief Deallocates the memory allocated for `pointer`. If for some reason the function cannot free the memory for this pointer, it does nothing. @param pointer pointer to free.
 TALLOC_DEF void tfree(void* pointer);
 
+/** 
+ * @brief   Same as `talloc`, but the returned pointer is a multiple of `alignment`. Returns `0` if `alignment` is not a power of two.
+ *          The chunk may take up to `alignment - 1` bytes more than `count`. Free it with `tfree`.
+ * @param count count of bytes to allocate.
+ * @param alignment power of two alignment of the returned pointer.
+ * @return Valid or zero pointer.
+ */
+TALLOC_DEF void* talloc_aligned(TALLOC_SIZE_TYPE count, TALLOC_SIZE_TYPE alignment);
+
+#define TALLOC_HINT_SHORT_LIVED 1
+#define TALLOC_HINT_LONG_LIVED 2
+#define TALLOC_HINT_HOT 4
+
+/** 
+ * @brief   Same as `talloc`, but places the block by how it is going to be used, so blocks of different lifetime do not interleave.
+ *          `TALLOC_HINT_LONG_LIVED` blocks are packed from the low end of the heap, `TALLOC_HINT_SHORT_LIVED` blocks from the high end,
+ *          so freed short lived blocks merge back into big free chunks instead of leaving holes between long lived ones.
+ *          `TALLOC_HINT_HOT` packs small blocks one after another into regions of `TALLOC_HOT_RESERVE_SIZE` bytes, one region per lifetime hint, placed by that hint.
+ *          Bigger hot blocks are placed by the lifetime hint only.
+ *          With no hint (or both lifetime hints) it places the block like `talloc`. Free it with `tfree`.
+ * @param count count of bytes to allocate.
+ * @param hints bitwise or of `TALLOC_HINT_*` values.
+ * @return Valid or zero pointer.
+ */
+TALLOC_DEF void* talloc_hint(TALLOC_SIZE_TYPE count, int hints);
+
+#define TALLOC_PREFAULT_NONE 0 // pages are faulted in on the first write
+#define TALLOC_PREFAULT_POPULATE 1 // mmap with MAP_POPULATE, pages are touched where it is not available
+#define TALLOC_PREFAULT_WILLNEED 2 // madvise(MADV_WILLNEED), pages are touched where it is not available
+#define TALLOC_PREFAULT_TOUCH 3 // one write per page
+
+struct talloc_config {
+    TALLOC_SIZE_TYPE heapSize; // bytes, 0 - TALLOC_MAX_HEAP_SIZE
+    int prefault; // TALLOC_PREFAULT_*, applied to the whole heap
+    int lockHeap; // mlock (VirtualLock on windows) the whole heap, which also faults it in
+    TALLOC_SIZE_TYPE seedChunks; // chunk descriptors to prepare now instead of on demand, up to TALLOC_MAX_HEAP_CHUNKS
+};
+
+/** 
+ * @brief   Initializes the heap explicitly, so the first `talloc`, `trealloc` or `talloc_heap_view` call does not do it.
+ *          Returns `0` if the heap is already initialized or the heap can not be created or locked, nothing is initialized in that case.
+ *          With `TALLOC_USE_STATIC` `heapSize` can not be bigger than `TALLOC_MAX_HEAP_SIZE`.
+ * @param config heap options, `0` for the defaults.
+ * @return Non zero on success.
+ */
+TALLOC_DEF int talloc_init(const struct talloc_config* config);
+
+/** 
+ * @brief   Faults in up to `bytes` of free heap memory, starting from where the next blocks are going to be carved from,
+ *          so the first writes to them do not page fault. If this is the first call, it initializes the heap, and an assert is triggered in case of failure.
+ * @param bytes count of bytes to prefault.
+ * @return Count of bytes prefaulted, less than `bytes` if there is not that much free memory.
+ */
+TALLOC_DEF TALLOC_SIZE_TYPE talloc_reserve(TALLOC_SIZE_TYPE bytes);
+
 #ifdef TALLOC_TESTING
 /// @brief Prints to stdout basic information about the heap and chunks used for the operation of the `talloc` and `tfree` functions. If this is the first call to this function, it initializes the heap, and an assert is triggered in case of failure.
 TALLOC_DEF void talloc_heap_view();
 #endif
 
+#ifdef __cplusplus
+}
+#endif
+
 #ifdef TALLOC_IMPLEMENTATION
 #ifndef TALLOC_MAX_HEAP_SIZE
 #   define TALLOC_MAX_HEAP_SIZE (1024*1024*4) // 4 mebibytes
@@ -90,12 +154,51 @@ TALLOC_DEF void talloc_heap_view();
 #   define TALLOC_USE_STATIC 0
 #endif
 
+#include <stdint.h>
+
+#ifndef TALLOC_BEST_FIT
+#   define TALLOC_BEST_FIT 0 // 0 - first fit, 1 - best (smallest fitting) fit
+#endif
+#ifndef TALLOC_PAGE_SIZE
+#   define TALLOC_PAGE_SIZE 4096 // step of the prefault touching, not bigger than the real page size
+#endif
+
+#ifndef TALLOC_HOT_RESERVE_SIZE
+#   define TALLOC_HOT_RESERVE_SIZE 4096 // TALLOC_HINT_HOT blocks up to a quarter of it are packed together in regions of this size
+#endif
+#define TALLOC__FIT_FIRST 0 // lowest address
+#define TALLOC__FIT_BEST 1 // smallest
+#define TALLOC__FIT_LAST 2 // highest address
+
+#ifdef TALLOC_PACKED_SEARCH
+#   if (TALLOC_MAX_HEAP_SIZE) > 0xFFFFFFFEull
+#       error "TALLOC_PACKED_SEARCH packs chunk sizes into 32 bits, TALLOC_MAX_HEAP_SIZE is too big"
+#   endif
+#   include <string.h>
+#   if !defined(TALLOC_NO_SIMD) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#       define TALLOC_PACKED_X86 1
+#       if defined(_MSC_VER) && !defined(__clang__)
+#           include <intrin.h>
+#           include <immintrin.h>
+#           define TALLOC_TARGET_SSE41
+#           define TALLOC_TARGET_AVX2
+#       else
+#           include <immintrin.h>
+#           define TALLOC_TARGET_SSE41 __attribute__((target("sse4.1")))
+#           define TALLOC_TARGET_AVX2 __attribute__((target("avx2")))
+#       endif
+#   else
+#       define TALLOC_PACKED_X86 0
+#   endif
+#endif // TALLOC_PACKED_SEARCH
+
 typedef struct heap_info_t {
 #if TALLOC_USE_STATIC
     char heapPointer[TALLOC_MAX_HEAP_SIZE];
 #else
     char* heapPointer;
 #endif
+    TALLOC_SIZE_TYPE size;
     TALLOC_BOOL initialized;
 } heap_info;
 
@@ -111,56 +214,443 @@ typedef struct heap_chunk_t {
 } heap_chunk;
 
 static heap_info tallocMainHeapInfo = {};
-static heap_chunk tallocChunks[TALLOC_MAX_HEAP_CHUNKS] = {0};
+static heap_chunk tallocChunks[TALLOC_MAX_HEAP_CHUNKS]; // zeroed as static storage
 static TALLOC_SIZE_TYPE tallocChunksCount = 0;
 static heap_chunk* tallocHollowChunks[TALLOC_MAX_HEAP_CHUNKS] = {0};
 static TALLOC_SIZE_TYPE tallocHollowChunksCount = 0;
+static TALLOC_SIZE_TYPE tallocChunksSeeded = 0; // tallocChunks[0, tallocChunksSeeded) have been handed out or pushed to tallocHollowChunks
 static heap_chunk* tallocHead;
+// the rest of the regions hot blocks are carved from, one per lifetime class (none, short, long),
+// marked as used so nothing else takes them or merges with them
+static heap_chunk* tallocHotReserves[3] = {0};
+
+#ifdef TALLOC_PACKED_SEARCH
+// Address ordered mirror of the chunk list. Every chunk of the list has one slot here,
+// free flag is folded into the value: used chunks are stored as 0, free chunks as their size.
+// So "free and big enough" is a single unsigned compare and can be scanned 8-16 slots at a time.
+static uint32_t tallocPackedSizes[TALLOC_MAX_HEAP_CHUNKS] = {0};
+static heap_chunk* tallocPackedChunks[TALLOC_MAX_HEAP_CHUNKS] = {0};
+static TALLOC_SIZE_TYPE tallocPackedCount = 0;
+
+// kernels return index of the found slot or `count` if nothing fits
+typedef TALLOC_SIZE_TYPE (*talloc_packed_kernel)(const uint32_t* sizes, TALLOC_SIZE_TYPE count, uint32_t need);
+typedef struct talloc_packed_engine_t {
+    talloc_packed_kernel firstFit;
+    talloc_packed_kernel bestFit;
+    talloc_packed_kernel lastFit;
+    const char* name;
+} talloc_packed_engine;
+
+TALLOC_DEF TALLOC_SIZE_TYPE talloc__packed_first_fit_scalar(const uint32_t* sizes, TALLOC_SIZE_TYPE count, uint32_t need) {
+    for (TALLOC_SIZE_TYPE i = 0; i < count; ++i) {
+        if (sizes[i] >= need)
+            return i;
+    }
+    return count;
+}
+TALLOC_DEF TALLOC_SIZE_TYPE talloc__packed_best_fit_scalar(const uint32_t* sizes, TALLOC_SIZE_TYPE count, uint32_t need) {
+    TALLOC_SIZE_TYPE best = count;
+    for (TALLOC_SIZE_TYPE i = 0; i < count; ++i) {
+        if ((sizes[i] >= need) && ((best == count) || (sizes[i] < sizes[best]))) {
+            best = i;
+            if (sizes[i] == need) // can't do better than exact fit
+                break;
+        }
+    }
+    return best;
+}
+TALLOC_DEF TALLOC_SIZE_TYPE talloc__packed_last_fit_scalar(const uint32_t* sizes, TALLOC_SIZE_TYPE count, uint32_t need) {
+    for (TALLOC_SIZE_TYPE i = count; i > 0; --i) {
+        if (sizes[i - 1] >= need)
+            return i - 1;
+    }
+    return count;
+}
+
+#if TALLOC_PACKED_X86
+// there is no unsigned 32 bit compare before avx512, so `v >= need` is `max(v, need) == v` (sse4.1 / avx2)
+static inline int talloc__ctz(unsigned int mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+static inline int talloc__bsr(unsigned int mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return (int)index;
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+}
+
+TALLOC_TARGET_SSE41 static inline int talloc__sse41_ge_mask(__m128i v, __m128i need) {
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_max_epu32(v, need), v)));
+}
+TALLOC_TARGET_SSE41 TALLOC_DEF TALLOC_SIZE_TYPE talloc__packed_first_fit_sse41(const uint32_t* sizes, TALLOC_SIZE_TYPE count, uint32_t need) {
+    const __m128i needv = _mm_set1_epi32((int)need);
+    TALLOC_SIZE_TYPE i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const int m0 = talloc__sse41_ge_mask(_mm_loadu_si128((const __m128i*)(sizes + i)), needv);
+        const int m1 = talloc__sse41_ge_mask(_mm_loadu_si128((const __m128i*)(sizes + i + 4)), needv);
+        const int m2 = talloc__sse41_ge_mask(_mm_loadu_si128((const __m128i*)(sizes + i + 8)), needv);
+        const int m3 = talloc__sse41_ge_mask(_mm_loadu_si128((const __m128i*)(sizes + i + 12)), needv);
+        const unsigned int mask = (unsigned int)(m0 | (m1 << 4) | (m2 << 8) | (m3 << 12));
+        if (mask != 0)
+            return i + talloc__ctz(mask);
+    }
+    return i + talloc__packed_first_fit_scalar(sizes + i, count - i, need);
+}
+TALLOC_TARGET_SSE41 TALLOC_DEF TALLOC_SIZE_TYPE talloc__packed_last_fit_sse41(const uint32_t* sizes, TALLOC_SIZE_TYPE count, uint32_t need) {
+    const __m128i needv = _mm_set1_epi32((int)need);
+    TALLOC_SIZE_TYPE i = count;
+    for (; i >= 16; i -= 16) {
+        const int m0 = talloc__sse41_ge_mask(_mm_loadu_si128((const __m128i*)(sizes + i - 16)), needv);
+        const int m1 = talloc__sse41_ge_mask(_mm_loadu_si128((const __m128i*)(sizes + i - 12)), needv);
+        const int m2 = talloc__sse41_ge_mask(_mm_loadu_si128((const __m128i*)(sizes + i - 8)), needv);
+        const int m3 = talloc__sse41_ge_mask(_mm_loadu_si128((const __m128i*)(sizes + i - 4)), needv);
+        const unsigned int mask = (unsigned int)(m0 | (m1 << 4) | (m2 << 8) | (m3 << 12));
+        if (mask != 0)
+            return i - 16 + talloc__bsr(mask);
+    }
+    const TALLOC_SIZE_TYPE index = talloc__packed_last_fit_scalar(sizes, i, need);
+    return index < i ? index : count;
+}
+TALLOC_TARGET_SSE41 TALLOC_DEF TALLOC_SIZE_TYPE talloc__packed_best_fit_sse41(const uint32_t* sizes, TALLOC_SIZE_TYPE count, uint32_t need) {
+    // first pass - smallest fitting value (not fitting ones are turned to 0xFFFFFFFF), second pass - its first index
+    const __m128i needv = _mm_set1_epi32((int)need);
+    const __m128i ones = _mm_set1_epi32(-1);
+    __m128i minv = ones;
+    TALLOC_SIZE_TYPE i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(sizes + i));
+        const __m128i fits = _mm_cmpeq_epi32(_mm_max_epu32(v, needv), v);
+        minv = _mm_min_epu32(minv, _mm_or_si128(v, _mm_andnot_si128(fits, ones)));
+    }
+    minv = _mm_min_epu32(minv, _mm_shuffle_epi32(minv, 0x4E));
+    minv = _mm_min_epu32(minv, _mm_shuffle_epi32(minv, 0xB1));
+    uint32_t best = (uint32_t)_mm_cvtsi128_si32(minv);
+    for (TALLOC_SIZE_TYPE j = i; j < count; ++j) {
+        if ((sizes[j] >= need) && (sizes[j] < best))
+            best = sizes[j];
+    }
+    if (best == 0xFFFFFFFFu)
+        return count;
+    const __m128i bestv = _mm_set1_epi32((int)best);
+    for (i = 0; i + 4 <= count; i += 4) {
+        const int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(sizes + i)), bestv)));
+        if (mask != 0)
+            return i + talloc__ctz((unsigned int)mask);
+    }
+    for (; i < count; ++i) {
+        if (sizes[i] == best)
+            return i;
+    }
+    return count;
+}
+
+TALLOC_TARGET_AVX2 static inline unsigned int talloc__avx2_ge_mask(__m256i v, __m256i need) {
+    return (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_max_epu32(v, need), v)));
+}
+TALLOC_TARGET_AVX2 TALLOC_DEF TALLOC_SIZE_TYPE talloc__packed_first_fit_avx2(const uint32_t* sizes, TALLOC_SIZE_TYPE count, uint32_t need) {
+    const __m256i needv = _mm256_set1_epi32((int)need);
+    TALLOC_SIZE_TYPE i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const unsigned int m0 = talloc__avx2_ge_mask(_mm256_loadu_si256((const __m256i*)(sizes + i)), needv);
+        const unsigned int m1 = talloc__avx2_ge_mask(_mm256_loadu_si256((const __m256i*)(sizes + i + 8)), needv);
+        const unsigned int mask = m0 | (m1 << 8);
+        if (mask != 0)
+            return i + talloc__ctz(mask);
+    }
+    return i + talloc__packed_first_fit_scalar(sizes + i, count - i, need);
+}
+TALLOC_TARGET_AVX2 TALLOC_DEF TALLOC_SIZE_TYPE talloc__packed_last_fit_avx2(const uint32_t* sizes, TALLOC_SIZE_TYPE count, uint32_t need) {
+    const __m256i needv = _mm256_set1_epi32((int)need);
+    TALLOC_SIZE_TYPE i = count;
+    for (; i >= 16; i -= 16) {
+        const unsigned int m0 = talloc__avx2_ge_mask(_mm256_loadu_si256((const __m256i*)(sizes + i - 16)), needv);
+        const unsigned int m1 = talloc__avx2_ge_mask(_mm256_loadu_si256((const __m256i*)(sizes + i - 8)), needv);
+        const unsigned int mask = m0 | (m1 << 8);
+        if (mask != 0)
+            return i - 16 + talloc__bsr(mask);
+    }
+    const TALLOC_SIZE_TYPE index = talloc__packed_last_fit_scalar(sizes, i, need);
+    return index < i ? index : count;
+}
+TALLOC_TARGET_AVX2 TALLOC_DEF TALLOC_SIZE_TYPE talloc__packed_best_fit_avx2(const uint32_t* sizes, TALLOC_SIZE_TYPE count, uint32_t need) {
+    const __m256i needv = _mm256_set1_epi32((int)need);
+    const __m256i ones = _mm256_set1_epi32(-1);
+    __m256i minv = ones;
+    TALLOC_SIZE_TYPE i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(sizes + i));
+        const __m256i fits = _mm256_cmpeq_epi32(_mm256_max_epu32(v, needv), v);
+        minv = _mm256_min_epu32(minv, _mm256_or_si256(v, _mm256_andnot_si256(fits, ones)));
+    }
+    __m128i min4 = _mm_min_epu32(_mm256_castsi256_si128(minv), _mm256_extracti128_si256(minv, 1));
+    min4 = _mm_min_epu32(min4, _mm_shuffle_epi32(min4, 0x4E));
+    min4 = _mm_min_epu32(min4, _mm_shuffle_epi32(min4, 0xB1));
+    uint32_t best = (uint32_t)_mm_cvtsi128_si32(min4);
+    for (TALLOC_SIZE_TYPE j = i; j < count; ++j) {
+        if ((sizes[j] >= need) && (sizes[j] < best))
+            best = sizes[j];
+    }
+    if (best == 0xFFFFFFFFu)
+        return count;
+    const __m256i bestv = _mm256_set1_epi32((int)best);
+    for (i = 0; i + 8 <= count; i += 8) {
+        const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(sizes + i)), bestv)));
+        if (mask != 0)
+            return i + talloc__ctz((unsigned int)mask);
+    }
+    for (; i < count; ++i) {
+        if (sizes[i] == best)
+            return i;
+    }
+    return count;
+}
+#endif // TALLOC_PACKED_X86
+
+static const talloc_packed_engine tallocPackedScalar = { talloc__packed_first_fit_scalar, talloc__packed_best_fit_scalar, talloc__packed_last_fit_scalar, "scalar" };
+#if TALLOC_PACKED_X86
+static const talloc_packed_engine tallocPackedSse41 = { talloc__packed_first_fit_sse41, talloc__packed_best_fit_sse41, talloc__packed_last_fit_sse41, "sse4.1" };
+static const talloc_packed_engine tallocPackedAvx2 = { talloc__packed_first_fit_avx2, talloc__packed_best_fit_avx2, talloc__packed_last_fit_avx2, "avx2" };
+#endif
+static const talloc_packed_engine* tallocPackedEngine = &tallocPackedScalar;
+
+// picks the widest kernels the cpu supports, called once on heap initialization
+TALLOC_DEF void talloc__packed_select_engine() {
+    tallocPackedEngine = &tallocPackedScalar;
+#if TALLOC_PACKED_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const TALLOC_BOOL sse41 = (info[2] & (1 << 19)) != 0;
+    const TALLOC_BOOL osAvx = ((info[2] & (1 << 27)) != 0) && ((info[2] & (1 << 28)) != 0) && ((_xgetbv(0) & 6) == 6);
+    TALLOC_BOOL avx2 = TALLOC_FALSE;
+    if (osAvx && (maxLeaf >= 7)) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const TALLOC_BOOL sse41 = __builtin_cpu_supports("sse4.1");
+    const TALLOC_BOOL avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2)
+        tallocPackedEngine = &tallocPackedAvx2;
+    else if (sse41)
+        tallocPackedEngine = &tallocPackedSse41;
+#endif // TALLOC_PACKED_X86
+}
+
+// binary search by address, returns index of the first chunk that does not start before `pointer`
+TALLOC_DEF TALLOC_SIZE_TYPE talloc__packed_lower_bound(const void* pointer) {
+    TALLOC_SIZE_TYPE low = 0;
+    TALLOC_SIZE_TYPE high = tallocPackedCount;
+    while (low < high) {
+        const TALLOC_SIZE_TYPE middle = low + (high - low) / 2;
+        if ((const char*)tallocPackedChunks[middle]->pointer < (const char*)pointer)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+// pass only chunk that is in the list
+TALLOC_DEF TALLOC_SIZE_TYPE talloc__packed_index_of(const heap_chunk* chunk) {
+    const TALLOC_SIZE_TYPE index = talloc__packed_lower_bound(chunk->pointer);
+    TALLOC_ASSERT((index < tallocPackedCount) && (tallocPackedChunks[index] == chunk));
+    return index;
+}
+static inline void talloc__packed_update(TALLOC_SIZE_TYPE index) {
+    const heap_chunk* chunk = tallocPackedChunks[index];
+    tallocPackedSizes[index] = chunk->isFree ? (uint32_t)chunk->count : 0;
+}
+TALLOC_DEF void talloc__packed_insert(TALLOC_SIZE_TYPE index, heap_chunk* chunk) {
+    memmove(tallocPackedSizes + index + 1, tallocPackedSizes + index, (tallocPackedCount - index) * sizeof(tallocPackedSizes[0]));
+    memmove(tallocPackedChunks + index + 1, tallocPackedChunks + index, (tallocPackedCount - index) * sizeof(tallocPackedChunks[0]));
+    tallocPackedChunks[index] = chunk;
+    ++tallocPackedCount;
+    talloc__packed_update(index);
+}
+TALLOC_DEF void talloc__packed_erase(TALLOC_SIZE_TYPE index, TALLOC_SIZE_TYPE count) {
+    memmove(tallocPackedSizes + index, tallocPackedSizes + index + count, (tallocPackedCount - index - count) * sizeof(tallocPackedSizes[0]));
+    memmove(tallocPackedChunks + index, tallocPackedChunks + index + count, (tallocPackedCount - index - count) * sizeof(tallocPackedChunks[0]));
+    tallocPackedCount -= count;
+}
+// `fit` is one of TALLOC__FIT_*
+TALLOC_DEF heap_chunk* talloc__packed_find(TALLOC_SIZE_TYPE count, int fit) {
+    if (count > 0xFFFFFFFFu)
+        return 0;
+    const talloc_packed_kernel kernel =
+        fit == TALLOC__FIT_BEST ? tallocPackedEngine->bestFit :
+        fit == TALLOC__FIT_LAST ? tallocPackedEngine->lastFit :
+        tallocPackedEngine->firstFit;
+    const TALLOC_SIZE_TYPE index = kernel(tallocPackedSizes, tallocPackedCount, (uint32_t)count);
+    return index < tallocPackedCount ? tallocPackedChunks[index] : 0;
+}
+#endif // TALLOC_PACKED_SEARCH
 
 void talloc_initialize_chunks() {
-    tallocChunks[0].count = TALLOC_MAX_HEAP_SIZE;
+    tallocChunks[0].count = tallocMainHeapInfo.size;
     tallocChunks[0].pointer = (void*)tallocMainHeapInfo.heapPointer;
     tallocChunks[0].isFree = TALLOC_TRUE;
     tallocChunks[0].prev = 0;
     tallocChunks[0].next = 0;
     tallocChunksCount = 1;
     tallocHead = &tallocChunks[0];
-    for (TALLOC_SIZE_TYPE i = 1; i < TALLOC_MAX_HEAP_CHUNKS; ++i) {
-        tallocHollowChunks[i] = &tallocChunks[i]; 
+    tallocChunksSeeded = 1; // the rest are seeded on demand or by talloc__seed_chunks
+    tallocHollowChunksCount = 0;
+    for (int i = 0; i < 3; ++i) {
+        tallocHotReserves[i] = 0;
+    }
+#ifdef TALLOC_PACKED_SEARCH
+    tallocPackedCount = 0;
+    talloc__packed_insert(0, &tallocChunks[0]);
+    talloc__packed_select_engine();
+#endif
+}
+// pushes up to `count` not yet used descriptors to the hollow stack, touching their memory
+TALLOC_DEF void talloc__seed_chunks(TALLOC_SIZE_TYPE count) {
+    for (; (count > 0) && (tallocChunksSeeded < TALLOC_MAX_HEAP_CHUNKS); --count) {
+        heap_chunk* chunk = &tallocChunks[tallocChunksSeeded++];
+        chunk->pointer = 0;
+        chunk->count = 0;
+        chunk->isFree = TALLOC_TRUE;
+        chunk->next = 0;
+        chunk->prev = 0;
+        tallocHollowChunks[tallocHollowChunksCount++] = chunk;
+    }
+}
+// writes one byte per page, so the pages are faulted in now and not on the first use
+TALLOC_DEF void talloc__touch(char* begin, TALLOC_SIZE_TYPE count) {
+    char* end = begin + count;
+    for (char* page = begin; page < end; page = (char*)(((uintptr_t)page | (TALLOC_PAGE_SIZE - 1)) + 1)) {
+        *(volatile char*)page = 0;
     }
-    tallocHollowChunksCount = TALLOC_MAX_HEAP_CHUNKS - 1;
 }
 #if TALLOC_USE_STATIC
-void talloc_initialize_heap() {
-    tallocMainHeapInfo.initialized = TALLOC_TRUE;
-    talloc_initialize_chunks();
+TALLOC_DEF TALLOC_BOOL talloc__map_heap(TALLOC_SIZE_TYPE size, int prefault) {
+    (void)prefault;
+    return size <= TALLOC_MAX_HEAP_SIZE;
 }
+TALLOC_DEF void talloc__unmap_heap() {}
 #else
 #ifdef __linux__
 #include <unistd.h>
 #include <sys/mman.h>
-void talloc_initialize_heap() {
-    tallocMainHeapInfo.heapPointer = (char*)mmap(0, TALLOC_MAX_HEAP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    tallocMainHeapInfo.initialized = tallocMainHeapInfo.heapPointer != MAP_FAILED;
-    TALLOC_ASSERT(tallocMainHeapInfo.initialized);
-    talloc_initialize_chunks();
+TALLOC_DEF TALLOC_BOOL talloc__map_heap(TALLOC_SIZE_TYPE size, int prefault) {
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_POPULATE
+    if (prefault == TALLOC_PREFAULT_POPULATE)
+        flags |= MAP_POPULATE;
+#else
+    (void)prefault;
+#endif
+    char* heapPointer = (char*)mmap(0, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (heapPointer == MAP_FAILED)
+        return TALLOC_FALSE;
+    tallocMainHeapInfo.heapPointer = heapPointer;
+    return TALLOC_TRUE;
+}
+TALLOC_DEF void talloc__unmap_heap() {
+    munmap(tallocMainHeapInfo.heapPointer, tallocMainHeapInfo.size);
 }
 #elif (defined __WIN32)
 #include <windows.h>
-void talloc_initialize_heap() {
-    tallocMainHeapInfo.heapPointer = (char*)VirtualAlloc(0, TALLOC_MAX_HEAP_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-    tallocMainHeapInfo.initialized = tallocMainHeapInfo.heapPointer != 0;
-    TALLOC_ASSERT(tallocMainHeapInfo.initialized);
-    talloc_initialize_chunks();
+TALLOC_DEF TALLOC_BOOL talloc__map_heap(TALLOC_SIZE_TYPE size, int prefault) {
+    (void)prefault;
+    char* heapPointer = (char*)VirtualAlloc(0, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (heapPointer == 0)
+        return TALLOC_FALSE;
+    tallocMainHeapInfo.heapPointer = heapPointer;
+    return TALLOC_TRUE;
+}
+TALLOC_DEF void talloc__unmap_heap() {
+    VirtualFree(tallocMainHeapInfo.heapPointer, 0, MEM_RELEASE);
 }
 #else
 #   error "platform not supported"
 #endif // linux or windows
 #endif // TALLOC_USE_STATIC
+#ifdef __linux__
+#include <sys/mman.h>
+TALLOC_DEF TALLOC_BOOL talloc__lock_heap() {
+    return mlock(tallocMainHeapInfo.heapPointer, tallocMainHeapInfo.size) == 0;
+}
+// returns false if the pages still have to be touched
+TALLOC_DEF TALLOC_BOOL talloc__prefault_heap(int prefault) {
+#ifdef MAP_POPULATE
+    if (prefault == TALLOC_PREFAULT_POPULATE)
+        return !TALLOC_USE_STATIC; // done by mmap
+#endif
+    if (prefault == TALLOC_PREFAULT_WILLNEED)
+        return madvise(tallocMainHeapInfo.heapPointer, tallocMainHeapInfo.size, MADV_WILLNEED) == 0;
+    return TALLOC_FALSE;
+}
+#elif (defined __WIN32)
+#include <windows.h>
+TALLOC_DEF TALLOC_BOOL talloc__lock_heap() {
+    return VirtualLock(tallocMainHeapInfo.heapPointer, tallocMainHeapInfo.size) != 0;
+}
+TALLOC_DEF TALLOC_BOOL talloc__prefault_heap(int prefault) {
+    (void)prefault;
+    return TALLOC_FALSE;
+}
+#else
+TALLOC_DEF TALLOC_BOOL talloc__lock_heap() {
+    return TALLOC_FALSE;
+}
+TALLOC_DEF TALLOC_BOOL talloc__prefault_heap(int prefault) {
+    (void)prefault;
+    return TALLOC_FALSE;
+}
+#endif // linux or windows
+TALLOC_DEF int talloc_init(const struct talloc_config* config) {
+    if (tallocMainHeapInfo.initialized)
+        return 0;
+    const struct talloc_config defaults = { 0, TALLOC_PREFAULT_NONE, 0, 0 };
+    if (config == 0)
+        config = &defaults;
+    const TALLOC_SIZE_TYPE size = config->heapSize != 0 ? config->heapSize : TALLOC_MAX_HEAP_SIZE;
+#ifdef TALLOC_PACKED_SEARCH
+    if (size > 0xFFFFFFFEu)
+        return 0;
+#endif
+    if (!talloc__map_heap(size, config->prefault))
+        return 0;
+    tallocMainHeapInfo.size = size;
+    if (config->lockHeap && !talloc__lock_heap()) {
+        talloc__unmap_heap();
+        return 0;
+    }
+    if ((config->prefault != TALLOC_PREFAULT_NONE) && !config->lockHeap && !talloc__prefault_heap(config->prefault))
+        talloc__touch(tallocMainHeapInfo.heapPointer, size);
+    tallocMainHeapInfo.initialized = TALLOC_TRUE;
+    talloc_initialize_chunks();
+    talloc__seed_chunks(config->seedChunks);
+    return 1;
+}
+void talloc_initialize_heap() {
+    const int initialized = talloc_init(0);
+    TALLOC_ASSERT(initialized);
+    (void)initialized;
+}
 TALLOC_DEF heap_chunk* talloc__pop_get_back_chunk() {
+    ++tallocChunksCount;
+    if (tallocHollowChunksCount == 0) { // not seeded yet
+        TALLOC_ASSERT(tallocChunksSeeded < TALLOC_MAX_HEAP_CHUNKS);
+        return &tallocChunks[tallocChunksSeeded++];
+    }
     heap_chunk* backChunk = tallocHollowChunks[tallocHollowChunksCount - 1];
     --tallocHollowChunksCount;
-    ++tallocChunksCount;
     return backChunk;
 }
 TALLOC_DEF void talloc__return_chunk(heap_chunk* toReturn) {
@@ -171,6 +661,9 @@ TALLOC_DEF void talloc__return_chunk(heap_chunk* toReturn) {
 // does not safe. Pass only valid chunk, please
 TALLOC_DEF void talloc__free_chunk(heap_chunk* chunk) {
     chunk->isFree = TALLOC_TRUE;
+#ifdef TALLOC_PACKED_SEARCH
+    const TALLOC_SIZE_TYPE packedIndex = talloc__packed_index_of(chunk);
+#endif
     heap_chunk* prev = chunk->prev;
     heap_chunk* next = chunk->next;
     const int mask = 
@@ -183,6 +676,10 @@ TALLOC_DEF void talloc__free_chunk(heap_chunk* chunk) {
         if (next->next != 0)
             next->next->prev = chunk;
         talloc__return_chunk(next);
+#ifdef TALLOC_PACKED_SEARCH
+        talloc__packed_erase(packedIndex + 1, 1);
+        talloc__packed_update(packedIndex);
+#endif
         break;
     } 
     case 2: {
@@ -191,6 +688,10 @@ TALLOC_DEF void talloc__free_chunk(heap_chunk* chunk) {
         if (next != 0)
             next->prev = prev;
         talloc__return_chunk(chunk);
+#ifdef TALLOC_PACKED_SEARCH
+        talloc__packed_erase(packedIndex, 1);
+        talloc__packed_update(packedIndex - 1);
+#endif
         break;
     } 
     case 3: {
@@ -200,31 +701,50 @@ TALLOC_DEF void talloc__free_chunk(heap_chunk* chunk) {
             next->next->prev = prev;
         talloc__return_chunk(chunk);
         talloc__return_chunk(next);
+#ifdef TALLOC_PACKED_SEARCH
+        talloc__packed_erase(packedIndex, 2);
+        talloc__packed_update(packedIndex - 1);
+#endif
         break;
     }
     default:
+#ifdef TALLOC_PACKED_SEARCH
+        talloc__packed_update(packedIndex);
+#endif
         break;
     }
 }
 // does not safe. Pass only valid FREE chunk, please
 TALLOC_DEF void* talloc__alloc_on_chunk(heap_chunk* chunk, TALLOC_SIZE_TYPE count) {
+#ifdef TALLOC_PACKED_SEARCH
+    const TALLOC_SIZE_TYPE packedIndex = talloc__packed_index_of(chunk);
+#endif
     if (chunk->next == 0) { // is a tale
         heap_chunk* next = chunk->next = talloc__pop_get_back_chunk();
         next->count = count;
         next->prev = chunk;
         next->next = 0;
         next->isFree = TALLOC_FALSE;    
-        next->pointer = chunk->pointer + chunk->count - count;
+        next->pointer = (char*)chunk->pointer + chunk->count - count;
         chunk->count -= count;
+#ifdef TALLOC_PACKED_SEARCH
+        talloc__packed_insert(packedIndex + 1, next);
+        talloc__packed_update(packedIndex);
+#endif
 
         if (chunk->count == 0) {
-            if (chunk->prev != 0)
-                chunk->prev->next = 0;
+            if (chunk->prev != 0) {
+                chunk->prev->next = next;
+                next->prev = chunk->prev;
+            }
             if (chunk == tallocHead) {
                 tallocHead = chunk->next;
                 tallocHead->prev = 0;
             };
             talloc__return_chunk(chunk);
+#ifdef TALLOC_PACKED_SEARCH
+            talloc__packed_erase(packedIndex, 1);
+#endif
         }
         return next->pointer;
     } else {
@@ -236,43 +756,200 @@ TALLOC_DEF void* talloc__alloc_on_chunk(heap_chunk* chunk, TALLOC_SIZE_TYPE coun
         curNext->prev = newNext;    
         newNext->isFree = TALLOC_FALSE;
         newNext->count = count;
-        newNext->pointer = chunk->pointer + chunk->count - count;
+        newNext->pointer = (char*)chunk->pointer + chunk->count - count;
         chunk->count -= count;
+#ifdef TALLOC_PACKED_SEARCH
+        talloc__packed_insert(packedIndex + 1, newNext);
+        talloc__packed_update(packedIndex);
+#endif
         if (chunk->count == 0) {
-            if (chunk->prev != 0)
+            if (chunk->prev != 0) {
                 chunk->prev->next = newNext;
+                newNext->prev = chunk->prev;
+            }
             if (chunk == tallocHead) {
                 tallocHead = chunk->next;
                 tallocHead->prev = 0;
             }
             talloc__return_chunk(chunk);
+#ifdef TALLOC_PACKED_SEARCH
+            talloc__packed_erase(packedIndex, 1);
+#endif
         }
         return newNext->pointer;
     }
     return 0;
 }
-TALLOC_DEF void* talloc(TALLOC_SIZE_TYPE count) {
-    if ((tallocChunksCount > TALLOC_MAX_HEAP_CHUNKS) || (count == 0))
-        return 0;
-    if (!tallocMainHeapInfo.initialized)
-        talloc_initialize_heap();
+// does not safe. Pass only valid FREE chunk, please. Same as talloc__alloc_on_chunk, but carves from the head of the chunk
+TALLOC_DEF void* talloc__alloc_on_chunk_head(heap_chunk* chunk, TALLOC_SIZE_TYPE count) {
+#ifdef TALLOC_PACKED_SEARCH
+    const TALLOC_SIZE_TYPE packedIndex = talloc__packed_index_of(chunk);
+#endif
+    if (chunk->count == count) {
+        chunk->isFree = TALLOC_FALSE;
+#ifdef TALLOC_PACKED_SEARCH
+        talloc__packed_update(packedIndex);
+#endif
+        return chunk->pointer;
+    }
+    heap_chunk* newPrev = talloc__pop_get_back_chunk();
+    heap_chunk* curPrev = chunk->prev;
+    newPrev->prev = curPrev;
+    newPrev->next = chunk;
+    newPrev->isFree = TALLOC_FALSE;
+    newPrev->count = count;
+    newPrev->pointer = chunk->pointer;
+    if (curPrev != 0)
+        curPrev->next = newPrev;
+    else
+        tallocHead = newPrev;
+    chunk->prev = newPrev;
+    chunk->pointer = (char*)chunk->pointer + count;
+    chunk->count -= count;
+#ifdef TALLOC_PACKED_SEARCH
+    talloc__packed_insert(packedIndex, newPrev);
+    talloc__packed_update(packedIndex + 1);
+#endif
+    return newPrev->pointer;
+}
+// serial walk over the chunk list, `fit` is one of TALLOC__FIT_*
+TALLOC_DEF heap_chunk* talloc__linked_find(TALLOC_SIZE_TYPE count, int fit) {
+    heap_chunk* best = 0;
     heap_chunk* current = tallocHead;
     while (current != 0) {
-        if ((current->isFree) && (current->count >= count))
-            return talloc__alloc_on_chunk(current, count);
+        if ((current->isFree) && (current->count >= count)) {
+            if ((fit == TALLOC__FIT_FIRST) || ((fit == TALLOC__FIT_BEST) && (current->count == count)))
+                return current;
+            if ((fit == TALLOC__FIT_LAST) || (best == 0) || (current->count < best->count))
+                best = current;
+        }
         current = current->next;
     }
-    return 0;
+    return best;
 }
-TALLOC_DEF void tfree(void* pointer) {
+TALLOC_DEF heap_chunk* talloc__find(TALLOC_SIZE_TYPE count, int fit) {
+#ifdef TALLOC_PACKED_SEARCH
+    return talloc__packed_find(count, fit);
+#else
+    return talloc__linked_find(count, fit);
+#endif
+}
+// chunk that starts at `pointer` or 0
+TALLOC_DEF heap_chunk* talloc__find_chunk(const void* pointer) {
+#ifdef TALLOC_PACKED_SEARCH
+    const TALLOC_SIZE_TYPE index = talloc__packed_lower_bound(pointer);
+    if ((index < tallocPackedCount) && (tallocPackedChunks[index]->pointer == pointer))
+        return tallocPackedChunks[index];
+#else
     heap_chunk* current = tallocHead;
     while (current != 0) {
-        if (current->pointer == pointer) {
-            talloc__free_chunk(current);
-            return;
-        }
+        if (current->pointer == pointer)
+            return current;
         current = current->next;
     }
+#endif
+    return 0;
+}
+TALLOC_DEF void* talloc(TALLOC_SIZE_TYPE count) {
+    if ((tallocChunksCount > TALLOC_MAX_HEAP_CHUNKS) || (count == 0))
+        return 0;
+    if (!tallocMainHeapInfo.initialized)
+        talloc_initialize_heap();
+    heap_chunk* found = talloc__find(count, TALLOC_BEST_FIT);
+    if (found != 0)
+        return talloc__alloc_on_chunk(found, count);
+    return 0;
+}
+TALLOC_DEF void* talloc_aligned(TALLOC_SIZE_TYPE count, TALLOC_SIZE_TYPE alignment) {
+    if ((tallocChunksCount > TALLOC_MAX_HEAP_CHUNKS) || (count == 0) || (alignment == 0) || ((alignment & (alignment - 1)) != 0))
+        return 0;
+    const TALLOC_SIZE_TYPE worstCount = count + alignment - 1;
+    if (worstCount < count) // overflow
+        return 0;
+    if (!tallocMainHeapInfo.initialized)
+        talloc_initialize_heap();
+    heap_chunk* found = talloc__find(worstCount, TALLOC_BEST_FIT);
+    if (found == 0)
+        return 0;
+    // chunks are carved from the tail, so the padding goes after the data and the chunk pointer stays aligned
+    const uintptr_t end = (uintptr_t)found->pointer + found->count;
+    const TALLOC_SIZE_TYPE padding = (TALLOC_SIZE_TYPE)((end - count) & (alignment - 1));
+    return talloc__alloc_on_chunk(found, count + padding);
+}
+// placement by lifetime hint only
+TALLOC_DEF void* talloc__alloc_by_lifetime(TALLOC_SIZE_TYPE count, int hints) {
+    switch (hints & (TALLOC_HINT_SHORT_LIVED | TALLOC_HINT_LONG_LIVED)) {
+    case TALLOC_HINT_LONG_LIVED: {
+        heap_chunk* found = talloc__find(count, TALLOC__FIT_FIRST);
+        return found != 0 ? talloc__alloc_on_chunk_head(found, count) : 0;
+    }
+    case TALLOC_HINT_SHORT_LIVED: {
+        heap_chunk* found = talloc__find(count, TALLOC__FIT_LAST);
+        return found != 0 ? talloc__alloc_on_chunk(found, count) : 0;
+    }
+    default: {
+        heap_chunk* found = talloc__find(count, TALLOC_BEST_FIT);
+        return found != 0 ? talloc__alloc_on_chunk(found, count) : 0;
+    }
+    }
+}
+// carves hot blocks one after another from the head of the reserve of their lifetime class
+TALLOC_DEF void* talloc__alloc_hot(TALLOC_SIZE_TYPE count, int hints) {
+    if (count > TALLOC_HOT_RESERVE_SIZE / 4)
+        return 0;
+    const int lifetime = hints & (TALLOC_HINT_SHORT_LIVED | TALLOC_HINT_LONG_LIVED);
+    heap_chunk** hotReserve = &tallocHotReserves[lifetime == (TALLOC_HINT_SHORT_LIVED | TALLOC_HINT_LONG_LIVED) ? 0 : lifetime];
+    if ((*hotReserve == 0) || ((*hotReserve)->count < count)) {
+        if (*hotReserve != 0) // give the rest back
+            talloc__free_chunk(*hotReserve);
+        void* reserve = talloc__alloc_by_lifetime(TALLOC_HOT_RESERVE_SIZE, hints);
+        *hotReserve = reserve != 0 ? talloc__find_chunk(reserve) : 0;
+        if (*hotReserve == 0)
+            return 0;
+    }
+    heap_chunk* reserve = *hotReserve;
+    reserve->isFree = TALLOC_TRUE;
+    void* pointer = talloc__alloc_on_chunk_head(reserve, count);
+    if (reserve->isFree) {
+        reserve->isFree = TALLOC_FALSE;
+#ifdef TALLOC_PACKED_SEARCH
+        talloc__packed_update(talloc__packed_index_of(reserve));
+#endif
+    } else { // the whole reserve became this block
+        *hotReserve = 0;
+    }
+    return pointer;
+}
+TALLOC_DEF void* talloc_hint(TALLOC_SIZE_TYPE count, int hints) {
+    if ((tallocChunksCount > TALLOC_MAX_HEAP_CHUNKS) || (count == 0))
+        return 0;
+    if (!tallocMainHeapInfo.initialized)
+        talloc_initialize_heap();
+    void* pointer = 0;
+    if (hints & TALLOC_HINT_HOT)
+        pointer = talloc__alloc_hot(count, hints);
+    if (pointer == 0)
+        pointer = talloc__alloc_by_lifetime(count, hints);
+    return pointer;
+}
+TALLOC_DEF TALLOC_SIZE_TYPE talloc_reserve(TALLOC_SIZE_TYPE bytes) {
+    if (!tallocMainHeapInfo.initialized)
+        talloc_initialize_heap();
+    // free chunks in the order talloc takes them, each from its tail
+    TALLOC_SIZE_TYPE reserved = 0;
+    for (heap_chunk* current = tallocHead; (current != 0) && (reserved < bytes); current = current->next) {
+        if (!current->isFree)
+            continue;
+        const TALLOC_SIZE_TYPE count = current->count < bytes - reserved ? current->count : bytes - reserved;
+        talloc__touch((char*)current->pointer + current->count - count, count);
+        reserved += count;
+    }
+    return reserved;
+}
+TALLOC_DEF void tfree(void* pointer) {
+    heap_chunk* chunk = talloc__find_chunk(pointer);
+    if (chunk != 0)
+        talloc__free_chunk(chunk);
 }
 void* trealloc(void* pointer, TALLOC_SIZE_TYPE count, const int copyOld) {
     if ((tallocChunksCount > TALLOC_MAX_HEAP_CHUNKS) || (count == 0)) {
@@ -285,28 +962,31 @@ void* trealloc(void* pointer, TALLOC_SIZE_TYPE count, const int copyOld) {
     heap_chunk* current = tallocHead;
     while (current != 0) {
         if (current->pointer == pointer) {
+#ifdef TALLOC_PACKED_SEARCH
+            const TALLOC_SIZE_TYPE packedIndex = talloc__packed_index_of(current);
+#endif
             if (current->count > count) {
                 if ((current->next == 0) || ((current->next != 0) && !current->next->isFree)) {
                     heap_chunk* curNext = current->next;
                     heap_chunk* newNext = current->next = talloc__pop_get_back_chunk();
                     newNext->isFree = TALLOC_TRUE;
                     newNext->count = current->count - count;
+                    newNext->pointer = (char*)current->pointer + count;
                     newNext->next = curNext;
-                    if ((curNext != 0) && (curNext->next != 0))
-                        curNext->next->prev = newNext;
+                    if (curNext != 0)
+                        curNext->prev = newNext;
                     newNext->prev = current;
+#ifdef TALLOC_PACKED_SEARCH
+                    talloc__packed_insert(packedIndex + 1, newNext);
+#endif
                 } else {
                     heap_chunk* next = current->next;
                     TALLOC_SIZE_TYPE delta = current->count - count;
-                    if (delta == next->count) {
-                        current->next = next->next;
-                        if (next->next != 0)
-                            next->next->prev = current;
-                        talloc__return_chunk(next);
-                    } else {
-                        next->pointer -= delta;
-                        next->count += delta;
-                    }
+                    next->pointer = (char*)next->pointer - delta;
+                    next->count += delta;
+#ifdef TALLOC_PACKED_SEARCH
+                    talloc__packed_update(packedIndex + 1);
+#endif
                 }
                 current->count = count;
                 return current->pointer;
@@ -338,7 +1018,10 @@ void* trealloc(void* pointer, TALLOC_SIZE_TYPE count, const int copyOld) {
                     } else if (next->count > delta){ 
                         current->count += delta;
                         next->count -= delta;
-                        next->pointer += delta;
+                        next->pointer = (char*)next->pointer + delta;
+#ifdef TALLOC_PACKED_SEARCH
+                        talloc__packed_update(packedIndex + 1);
+#endif
                         return current->pointer;
                     } else { //  equal
                         current->count += delta;
@@ -346,6 +1029,9 @@ void* trealloc(void* pointer, TALLOC_SIZE_TYPE count, const int copyOld) {
                         if (next->next != 0)
                             next->next->prev = current;
                         talloc__return_chunk(next);
+#ifdef TALLOC_PACKED_SEARCH
+                        talloc__packed_erase(packedIndex + 1, 1);
+#endif
                         return current->pointer;
                     }
                 }